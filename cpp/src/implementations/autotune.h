@@ -0,0 +1,309 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <map>
+#include <pqxx/pqxx>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "avx2.h"
+#include "int64.h"
+#include "plain.h"
+#include "sse.h"
+#include "threads.h"
+#include "trie.h"
+
+namespace autotune {
+struct Choice {
+    std::string type;
+    int pages;
+};
+
+// Picks the fastest matcher for the current host and data by running every
+// candidate on all the users against samples of the events, loading them the
+// way the candidate loads all the events, and extrapolating its time to all
+// the events. The decision is cached per host and data shape, so that only
+// the first run pays for the calibration.
+class Tuner {
+ public:
+    Choice choose(pqxx::work &db) {
+        const auto start { std::chrono::steady_clock::now() };
+
+        const auto events { db.exec(sampleQuery(LargeSample)) };
+        const auto key { shapeKey(db, events) };
+        auto cache { loadCache() };
+
+        if (const auto cached { cache.find(key) }; cached != cache.end() && isCandidate(cached->second)) {
+            std::cout << "Engine " << describe(cached->second) << " picked from cache." << std::endl;
+            return cached->second;
+        }
+
+        const auto users { db.exec("select slots from users") };
+        const auto choice { calibrate(db, users) };
+        cache[key] = choice;
+        saveCache(cache);
+
+        const auto end { std::chrono::steady_clock::now() };
+        const auto duration { std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() };
+        std::cout << "Engine " << describe(choice) << " picked by calibration in " << duration << " ms." << std::endl;
+        return choice;
+    }
+
+ private:
+    // Every candidate is timed on two samples of the events, to tell the
+    // costs paid once per run, such as queries and connections, from the
+    // costs paid per event.
+    static constexpr auto SmallSample { 100 };
+    static constexpr auto LargeSample { 500 };
+    static constexpr auto Repeats { 3 };
+
+    // Part of the shape key, so that changing the candidates or how they are
+    // measured invalidates the decisions cached before.
+    static constexpr auto CandidatesVersion { 3 };
+
+    static std::string sampleQuery(int sample) {
+        return "select id, slots from events limit " + std::to_string(sample);
+    }
+
+    template <typename Matcher>
+    static auto convert(const pqxx::result &rows, int column) {
+        std::vector<decltype(Matcher::byteaToSlots(rows[0][0]))> slots { };
+        for (auto row : rows) {
+            slots.push_back(Matcher::byteaToSlots(row[column]));
+        }
+
+        return slots;
+    }
+
+    template <typename Kernel>
+    static std::chrono::nanoseconds fastest(Kernel kernel) {
+        auto best { std::chrono::nanoseconds::max() };
+        for (auto i { 0 }; i < Repeats; ++i) {
+            const auto start { std::chrono::steady_clock::now() };
+            const volatile auto total { kernel() };
+            (void)total;
+            const auto end { std::chrono::steady_clock::now() };
+            best = std::min(best, std::chrono::duration_cast<std::chrono::nanoseconds>(end - start));
+        }
+
+        return best;
+    }
+
+    // Fits `fixed + perEvent * n` through the timings of both samples, and
+    // evaluates it at the number of events of the real run.
+    template <typename Measure>
+    static double estimate(Measure measure, int countEvents) {
+        const auto small { std::min(SmallSample, countEvents) };
+        const auto large { std::min(LargeSample, countEvents) };
+        const auto smallTime { static_cast<double>(measure(small).count()) };
+        const auto largeTime { static_cast<double>(measure(large).count()) };
+        if (large == small) {
+            return largeTime;
+        }
+
+        const auto perEvent { std::max(0.0, (largeTime - smallTime) / (large - small)) };
+        const auto fixed { std::max(0.0, smallTime - perEvent * small) };
+        return fixed + perEvent * countEvents;
+    }
+
+    static Choice calibrate(pqxx::work &db, const pqxx::result &users) {
+        const auto countEvents { db.exec("select count(*) from events")[0][0].as<int>() };
+
+        std::vector<std::pair<Choice, double>> timings {
+            { { "plain", 0 }, estimate([&](int sample) { return measure<plain::Matcher>(db, users, sample); }, countEvents) },
+            { { "sse", 0 }, estimate([&](int sample) { return measure<sse::Matcher>(db, users, sample); }, countEvents) },
+            { { "avx2", 0 }, estimate([&](int sample) { return measure<avx2::Matcher>(db, users, sample); }, countEvents) },
+            { { "int64", 0 }, estimate([&](int sample) { return measure<int64::Matcher>(db, users, sample); }, countEvents) },
+            { { "trie", 0 }, estimate([&](int sample) { return measureTrie(db, users, sample); }, countEvents) },
+        };
+
+        for (const auto pages : threadsCandidates()) {
+            const auto threadsTime { estimate([&](int sample) { return measureThreads(users, pages, sample); }, countEvents) };
+            timings.push_back({ { "threads", pages }, threadsTime });
+        }
+
+        const auto best { std::ranges::min_element(timings, { }, [](const auto &t) { return t.second; }) };
+        return best->first;
+    }
+
+    // Like the matchers, the single-threaded candidates load the events with
+    // one query, then convert and match them.
+    template <typename Matcher>
+    static std::chrono::nanoseconds measure(pqxx::work &db, const pqxx::result &usersRows, int sample) {
+        const auto users { convert<Matcher>(usersRows, 0) };
+
+        return fastest([&] {
+            const auto events { convert<Matcher>(db.exec(sampleQuery(sample)), 1) };
+            auto total { 0L };
+            for (const auto &eventSlots : events) {
+                total += Matcher::matches(eventSlots, users);
+            }
+
+            return total;
+        });
+    }
+
+    // Goes through the pages of the threaded matcher, each with its own
+    // connection and query, restricted to the sampled events.
+    static std::chrono::nanoseconds measureThreads(const pqxx::result &usersRows, int pages, int sample) {
+        const auto users { convert<threads::Matcher>(usersRows, 0) };
+        const auto pageSize { std::max(1, (sample + pages - 1) / pages) };
+
+        return fastest([&] {
+            std::vector<std::future<std::map<int, int>>> tasks { };
+            for (auto skip { 0 }; skip < sample; skip += pageSize) {
+                const auto take { std::min(pageSize, sample - skip) };
+                tasks.emplace_back(std::async(std::launch::async, threads::Matcher::matchPage, &users, skip, take));
+            }
+
+            auto total { 0L };
+            for (auto &task : tasks) {
+                for (const auto &[eventId, count] : task.get()) {
+                    total += count;
+                }
+            }
+
+            return total;
+        });
+    }
+
+    // Like the conversion of the users for the other matchers, building the
+    // index is not timed.
+    static std::chrono::nanoseconds measureTrie(pqxx::work &db, const pqxx::result &usersRows, int sample) {
+        const trie::Index index { convert<trie::Matcher>(usersRows, 0) };
+
+        return fastest([&] {
+            const auto events { convert<trie::Matcher>(db.exec(sampleQuery(sample)), 1) };
+            auto total { 0L };
+            for (const auto &eventSlots : events) {
+                total += index.matches(eventSlots);
+            }
+
+            return total;
+        });
+    }
+
+    static std::vector<int> threadsCandidates() {
+        const auto cores { static_cast<int>(std::max(1u, std::thread::hardware_concurrency())) };
+        std::vector<int> candidates { std::max(1, cores / 2), cores, threads::Matcher::DefaultPages };
+        for (auto &pages : candidates) {
+            pages = std::min(pages, threads::Matcher::MaxPages);
+        }
+
+        std::ranges::sort(candidates);
+        const auto duplicates { std::ranges::unique(candidates) };
+        candidates.erase(duplicates.begin(), duplicates.end());
+        return candidates;
+    }
+
+    // Whether a cached choice is one the calibration could have made, so
+    // that a stale or corrupt cache leads to a new calibration.
+    static bool isCandidate(const Choice &choice) {
+        if (choice.type == "threads") {
+            const auto candidates { threadsCandidates() };
+            return std::ranges::find(candidates, choice.pages) != candidates.end();
+        }
+
+        constexpr std::array types { "plain", "sse", "avx2", "int64", "trie" };
+        return choice.pages == 0 && std::ranges::any_of(types, [&](const char *type) { return choice.type == type; });
+    }
+
+    // Describes everything the decision depends on: the candidates, the
+    // machine, the number of users and events, and how many slots an event
+    // spans on average. The average is truncated to whole slots so that
+    // regenerating the data with the same parameters reuses the decision.
+    static std::string shapeKey(pqxx::work &db, const pqxx::result &events) {
+        const auto counts { db.exec("select (select count(*) from users), (select count(*) from events)") };
+
+        auto eventBits { 0L };
+        for (auto row : events) {
+            const pqxx::binarystring blob { row[1] };
+            for (size_t i { 0 }; i < blob.size(); ++i) {
+                eventBits += std::popcount(static_cast<unsigned char>(blob.data()[i]));
+            }
+        }
+
+        const auto averageEventBits { events.empty() ? 0L : eventBits / static_cast<long>(events.size()) };
+
+        std::array<char, 256> host { };
+        gethostname(host.data(), host.size() - 1);
+
+        std::ostringstream key { };
+        key
+            << host.data()
+            << ";candidates=" << CandidatesVersion
+            << ";cores=" << std::thread::hardware_concurrency()
+            << ";avx2=" << __builtin_cpu_supports("avx2")
+            << ";avx512=" << __builtin_cpu_supports("avx512f")
+            << ";users=" << counts[0][0].as<long>()
+            << ";events=" << counts[0][1].as<long>()
+            << ";event-bits=" << averageEventBits;
+        return key.str();
+    }
+
+    static std::string describe(const Choice &choice) {
+        if (choice.type == "threads") {
+            return choice.type + " (" + std::to_string(choice.pages) + " pages)";
+        }
+
+        return choice.type;
+    }
+
+    static std::filesystem::path cachePath() {
+        if (const auto path { std::getenv("SCHEDULES_AUTOTUNE_CACHE") }) {
+            return path;
+        }
+
+        if (const auto cache { std::getenv("XDG_CACHE_HOME") }) {
+            return std::filesystem::path { cache } / "schedules" / "autotune";
+        }
+
+        if (const auto home { std::getenv("HOME") }) {
+            return std::filesystem::path { home } / ".cache" / "schedules" / "autotune";
+        }
+
+        return ".schedules-autotune";
+    }
+
+    // One decision per line: the shape key, the engine type and its pages.
+    static std::map<std::string, Choice> loadCache() {
+        std::map<std::string, Choice> cache { };
+        std::ifstream file { cachePath() };
+        std::string key { };
+        Choice choice { };
+        while (file >> key >> choice.type >> choice.pages) {
+            cache[key] = choice;
+        }
+
+        return cache;
+    }
+
+    static void saveCache(const std::map<std::string, Choice> &cache) {
+        const auto path { cachePath() };
+        std::error_code error { };
+        if (path.has_parent_path()) {
+            std::filesystem::create_directories(path.parent_path(), error);
+        }
+
+        std::ofstream file { path };
+        for (const auto &[key, choice] : cache) {
+            file << key << " " << choice.type << " " << choice.pages << std::endl;
+        }
+
+        if (!file) {
+            std::cerr << "Cannot save the engine choice to " << path << "." << std::endl;
+        }
+    }
+};
+}
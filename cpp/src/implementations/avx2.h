@@ -1,3 +1,5 @@
+#pragma once
+
 #include <algorithm>
 #include <chrono>
 #include <emmintrin.h>
@@ -7,12 +9,16 @@
 #include <pqxx/pqxx>
 #include <ranges>
 
+#include "../trace.h"
+
 namespace avx2 {
 class Slots {
  public:
-    explicit Slots(const pqxx::binarystring &blob) :
-        head { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(blob.data())) },
-        tail { _mm_loadu_si128(reinterpret_cast<const __m128i*>(blob.data() + 26)) } { }
+    explicit Slots(const pqxx::binarystring &blob) : Slots { blob.data() } { }
+
+    explicit Slots(const unsigned char *data) :
+        head { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)) },
+        tail { _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 26)) } { }
 
     bool matches(const Slots &other) const {
         return
@@ -50,8 +56,13 @@ class Matcher {
         const auto startMatch { std::chrono::steady_clock::now() };
         std::map<int, int> counters { };
 
-        pqxx::result result { db.exec("select id, slots from events") };
+        pqxx::result result { };
+        {
+            TRACE_SCOPE("load events");
+            result = db.exec("select id, slots from events");
+        }
 
+        TRACE_SCOPE("match events");
         for (auto row : result) {
             const auto eventId { row[0].as<int>() };
             const auto eventSlots { byteaToSlots(row[1]) };
@@ -64,9 +75,6 @@ class Matcher {
         return counters;
     }
 
- private:
-    static constexpr size_t SlotsLength { 42 };
-
     static Slots byteaToSlots(pqxx::field const &field)
     {
         pqxx::binarystring blob { field };
@@ -74,14 +82,8 @@ class Matcher {
         return Slots { blob };
     }
 
-    static std::vector<Slots> loadUsers(pqxx::work &db) {
-        std::vector<Slots> slots { };
-        pqxx::result result { db.exec("select slots from users;") };
-        for (auto row : result) {
-            slots.push_back(byteaToSlots(row[0]));
-        }
-
-        return slots;
+    static Slots bytesToSlots(const unsigned char *data) {
+        return Slots { data };
     }
 
     static int matches(const Slots &eventSlots, const std::vector<Slots> &users) {
@@ -95,5 +97,24 @@ class Matcher {
 
         return counter;
     }
+
+ private:
+    static constexpr size_t SlotsLength { 42 };
+
+    static std::vector<Slots> loadUsers(pqxx::work &db) {
+        std::vector<Slots> slots { };
+        pqxx::result result { };
+        {
+            TRACE_SCOPE("load users");
+            result = db.exec("select slots from users;");
+        }
+
+        TRACE_SCOPE("convert users");
+        for (auto row : result) {
+            slots.push_back(byteaToSlots(row[0]));
+        }
+
+        return slots;
+    }
 };
 }
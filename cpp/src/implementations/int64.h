@@ -1,3 +1,5 @@
+#pragma once
+
 #include <algorithm>
 #include <chrono>
 #include <iostream>
@@ -5,13 +7,16 @@
 #include <pqxx/pqxx>
 #include <ranges>
 
+#include "../trace.h"
+
 namespace int64 {
 constexpr size_t SlotsLength { 42 };
 
 class Slots {
  public:
-    explicit Slots(const pqxx::binarystring &blob) {
-        const auto data { blob.data() };
+    explicit Slots(const pqxx::binarystring &blob) : Slots { blob.data() } { }
+
+    explicit Slots(const unsigned char *data) {
         std::memcpy(&head[0], data, 8 * 5);
         std::memcpy(&tail, data + (8 * 5), 2);
     }
@@ -49,8 +54,13 @@ class Matcher {
         const auto startMatch { std::chrono::steady_clock::now() };
         std::map<int, int> counters { };
 
-        pqxx::result result { db.exec("select id, slots from events") };
+        pqxx::result result { };
+        {
+            TRACE_SCOPE("load events");
+            result = db.exec("select id, slots from events");
+        }
 
+        TRACE_SCOPE("match events");
         for (auto row : result) {
             const auto eventId { row[0].as<int>() };
             const auto eventSlots { byteaToSlots(row[1]) };
@@ -63,23 +73,14 @@ class Matcher {
         return counters;
     }
 
- private:
-    static constexpr size_t SlotsLength { 42 };
-
     static Slots byteaToSlots(pqxx::field const &field) {
         pqxx::binarystring blob { field };
         assert(blob.size() - 1 == SlotsLength);
         return Slots { blob };
     }
 
-    static std::vector<Slots> loadUsers(pqxx::work &db) {
-        std::vector<Slots> slots { };
-        pqxx::result result { db.exec("select slots from users;") };
-        for (auto row : result) {
-            slots.push_back(byteaToSlots(row[0]));
-        }
-
-        return slots;
+    static Slots bytesToSlots(const unsigned char *data) {
+        return Slots { data };
     }
 
     static int matches(const Slots &eventSlots, const std::vector<Slots> &users) {
@@ -93,5 +94,24 @@ class Matcher {
 
         return counter;
     }
+
+ private:
+    static constexpr size_t SlotsLength { 42 };
+
+    static std::vector<Slots> loadUsers(pqxx::work &db) {
+        std::vector<Slots> slots { };
+        pqxx::result result { };
+        {
+            TRACE_SCOPE("load users");
+            result = db.exec("select slots from users;");
+        }
+
+        TRACE_SCOPE("convert users");
+        for (auto row : result) {
+            slots.push_back(byteaToSlots(row[0]));
+        }
+
+        return slots;
+    }
 };
 }
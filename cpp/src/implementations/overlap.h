@@ -0,0 +1,179 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <immintrin.h>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <pqxx/pqxx>
+#include <vector>
+
+#include "../trace.h"
+
+namespace overlap {
+constexpr size_t SlotsLength { 42 };
+
+// Slots zero-padded to a full cache line, so that the padding never adds to
+// the count of common slots.
+class Slots {
+ public:
+    explicit Slots(const pqxx::binarystring &blob) : Slots { blob.data() } { }
+
+    explicit Slots(const unsigned char *data) {
+        std::memcpy(this->bytes.data(), data, SlotsLength);
+    }
+
+    // Number of slots set in both.
+    int overlap(const Slots &other) const {
+        const auto low {
+            _mm256_and_si256(
+                _mm256_load_si256(reinterpret_cast<const __m256i*>(this->bytes.data())),
+                _mm256_load_si256(reinterpret_cast<const __m256i*>(other.bytes.data()))) };
+
+        const auto high {
+            _mm256_and_si256(
+                _mm256_load_si256(reinterpret_cast<const __m256i*>(this->bytes.data() + 32)),
+                _mm256_load_si256(reinterpret_cast<const __m256i*>(other.bytes.data() + 32))) };
+
+#if defined(__AVX512VPOPCNTDQ__) && defined(__AVX512VL__)
+        const auto counts { _mm256_add_epi64(_mm256_popcnt_epi64(low), _mm256_popcnt_epi64(high)) };
+#else
+        // At most 16 per byte, so the sum of both halves cannot overflow.
+        const auto counts { _mm256_sad_epu8(_mm256_add_epi8(popcount8(low), popcount8(high)), _mm256_setzero_si256()) };
+#endif
+
+        const auto sum { _mm_add_epi64(_mm256_castsi256_si128(counts), _mm256_extracti128_si256(counts, 1)) };
+        return static_cast<int>(_mm_cvtsi128_si64(sum) + _mm_extract_epi64(sum, 1));
+    }
+
+    int size() const {
+        return this->overlap(*this);
+    }
+
+ private:
+    alignas(64) std::array<unsigned char, 64> bytes { };
+
+#if !(defined(__AVX512VPOPCNTDQ__) && defined(__AVX512VL__))
+    // Population count of every byte, with a nibble lookup table.
+    static __m256i popcount8(const __m256i &v) {
+        const auto lookup { _mm256_setr_epi8(
+            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4) };
+        const auto nibble { _mm256_set1_epi8(0x0F) };
+        const auto low { _mm256_and_si256(v, nibble) };
+        const auto high { _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble) };
+        return _mm256_add_epi8(_mm256_shuffle_epi8(lookup, low), _mm256_shuffle_epi8(lookup, high));
+    }
+#endif
+};
+
+// Scores users by how many of the slots of an event they can attend, rather
+// than by whether they can attend all of them.
+class Matcher {
+ public:
+    // Same output as the other matchers: the users available for the whole
+    // event, which is the last bucket of its histogram.
+    std::map<int, int> match(pqxx::work &db) {
+        std::map<int, int> counters { };
+        for (const auto &[eventId, histogram] : this->histograms(db)) {
+            counters[eventId] = histogram.back();
+        }
+
+        return counters;
+    }
+
+    // For every event, the number of users sharing exactly `i` slots with it,
+    // for `i` from zero to the number of slots of the event.
+    std::map<int, std::vector<int>> histograms(pqxx::work &db) {
+        const auto startUsers { std::chrono::steady_clock::now() };
+        const auto users { loadUsers(db) };
+        const auto endUsers { std::chrono::steady_clock::now() };
+        const auto usersDuration { std::chrono::duration_cast<std::chrono::milliseconds>(endUsers - startUsers).count() };
+
+        std::cout << users.size() << " users loaded in " << usersDuration << " ms." << std::endl;
+
+        const auto startMatch { std::chrono::steady_clock::now() };
+        std::map<int, std::vector<int>> histograms { };
+
+        pqxx::result result { };
+        {
+            TRACE_SCOPE("load events");
+            result = db.exec("select id, slots from events");
+        }
+
+        TRACE_SCOPE("match events");
+        for (auto row : result) {
+            const auto eventId { row[0].as<int>() };
+            const auto eventSlots { byteaToSlots(row[1]) };
+            histograms[eventId] = histogram(eventSlots, users);
+        }
+
+        const auto endMatch { std::chrono::steady_clock::now() };
+        const auto matchDuration { std::chrono::duration_cast<std::chrono::milliseconds>(endMatch - startMatch).count() };
+        std::cout << "Overlaps computed in " << matchDuration << " ms." << std::endl;
+        return histograms;
+    }
+
+    static Slots byteaToSlots(pqxx::field const &field) {
+        pqxx::binarystring blob { field };
+        assert(blob.size() - 1 == SlotsLength);
+        return Slots { blob };
+    }
+
+    static Slots bytesToSlots(const unsigned char *data) {
+        return Slots { data };
+    }
+
+    static std::vector<int> histogram(const Slots &eventSlots, const std::vector<Slots> &users) {
+        std::vector<int> histogram(eventSlots.size() + 1, 0);
+
+        for (const auto &userSlots : users) {
+            ++histogram[eventSlots.overlap(userSlots)];
+        }
+
+        return histogram;
+    }
+
+    // Number of slots every user shares with the event, in the order of the
+    // users, to rank them by availability.
+    static std::vector<int> scores(const Slots &eventSlots, const std::vector<Slots> &users) {
+        std::vector<int> scores(users.size());
+        for (size_t i { 0 }; i < users.size(); ++i) {
+            scores[i] = eventSlots.overlap(users[i]);
+        }
+
+        return scores;
+    }
+
+    // Users sharing at least `ratio` of the slots of the event, such as 0.8
+    // for "free for at least 80% of the workshop". The tolerance keeps a
+    // product such as 0.28 * 25, which is 7.000000000000001 in binary, from
+    // rounding up to the next slot.
+    static int atLeast(const std::vector<int> &histogram, double ratio) {
+        const auto size { static_cast<int>(histogram.size()) - 1 };
+        const auto threshold { std::clamp(static_cast<int>(std::ceil(ratio * size - 1e-9)), 0, size) };
+        return std::accumulate(histogram.begin() + threshold, histogram.end(), 0);
+    }
+
+ private:
+    static std::vector<Slots> loadUsers(pqxx::work &db) {
+        std::vector<Slots> slots { };
+        pqxx::result result { };
+        {
+            TRACE_SCOPE("load users");
+            result = db.exec("select slots from users;");
+        }
+
+        TRACE_SCOPE("convert users");
+        for (auto row : result) {
+            slots.push_back(byteaToSlots(row[0]));
+        }
+
+        return slots;
+    }
+};
+}
@@ -1,3 +1,5 @@
+#pragma once
+
 #include <algorithm>
 #include <chrono>
 #include <emmintrin.h>
@@ -7,6 +9,8 @@
 #include <pqxx/pqxx>
 #include <ranges>
 
+#include "../trace.h"
+
 namespace plain {
 constexpr size_t SlotsLength { 42 };
 using Slots = std::array<std::byte, SlotsLength>;
@@ -24,8 +28,13 @@ class Matcher {
         const auto startMatch { std::chrono::steady_clock::now() };
         std::map<int, int> counters { };
 
-        pqxx::result result { db.exec("select id, slots from events") };
+        pqxx::result result { };
+        {
+            TRACE_SCOPE("load events");
+            result = db.exec("select id, slots from events");
+        }
 
+        TRACE_SCOPE("match events");
         for (auto row : result) {
             const auto eventId { row[0].as<int>() };
             const auto eventSlots { byteaToSlots(row[1]) };
@@ -38,23 +47,44 @@ class Matcher {
         return counters;
     }
 
- private:
-    static constexpr size_t SlotsLength { 42 };
-
     static Slots byteaToSlots(pqxx::field const &field) {
         pqxx::binarystring blob { field };
         assert(blob.size() - 1 == SlotsLength);
+        return bytesToSlots(blob.data());
+    }
 
-        const std::byte* source { reinterpret_cast<const std::byte*>(blob.data()) };
+    static Slots bytesToSlots(const unsigned char *data) {
+        const std::byte* source { reinterpret_cast<const std::byte*>(data) };
 
         Slots result;
         std::copy_n(source, SlotsLength, result.begin());
         return result;
     }
 
+    static int matches(const Slots &eventSlots, const std::vector<Slots> &users) {
+        auto counter { 0 };
+
+        for (const auto &userSlots : users) {
+            if (matches(eventSlots, userSlots)) {
+                ++counter;
+            }
+        }
+
+        return counter;
+    }
+
+ private:
+    static constexpr size_t SlotsLength { 42 };
+
     static std::vector<Slots> loadUsers(pqxx::work &db) {
         std::vector<Slots> slots { };
-        pqxx::result result { db.exec("select slots from users;") };
+        pqxx::result result { };
+        {
+            TRACE_SCOPE("load users");
+            result = db.exec("select slots from users;");
+        }
+
+        TRACE_SCOPE("convert users");
         for (auto row : result) {
             slots.push_back(byteaToSlots(row[0]));
         }
@@ -73,17 +103,5 @@ class Matcher {
 
         return true;
     }
-
-    static int matches(const Slots &eventSlots, const std::vector<Slots> &users) {
-        auto counter { 0 };
-
-        for (const auto &userSlots : users) {
-            if (matches(eventSlots, userSlots)) {
-                ++counter;
-            }
-        }
-
-        return counter;
-    }
 };
 }
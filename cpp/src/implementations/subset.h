@@ -0,0 +1,162 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace subset {
+constexpr size_t SlotsLength { 42 };
+constexpr size_t CountSlots { SlotsLength * 8 };
+constexpr size_t CountWords { (CountSlots + 63) / 64 };
+
+// Slots as a little-endian integer: slot `s` is bit `s % 64` of word `s / 64`,
+// like the integer the Python side stores big-endian in the database.
+using Slots = std::array<uint64_t, CountWords>;
+
+struct Start {
+    int slot;
+    int count;
+};
+
+// Counts the attendees free at every start slot. Each attendee contributes
+// the slots starting a long enough free run; these are added to bit-sliced
+// counters, one plane per bit of the count, so that every attendee updates all
+// the slots with a few word operations instead of one increment per slot.
+class Counter {
+ public:
+    explicit Counter(int duration) : duration { std::clamp(duration, 1, static_cast<int>(CountSlots)) } { }
+
+    void add(const Slots &user) {
+        auto carry { runStarts(user, this->duration) };
+        for (auto &plane : this->planes) {
+            auto any { 0UL };
+            for (size_t i { 0 }; i < CountWords; ++i) {
+                const auto next { plane[i] & carry[i] };
+                plane[i] ^= carry[i];
+                carry[i] = next;
+                any |= next;
+            }
+
+            if (any == 0) {
+                return;
+            }
+        }
+
+        this->planes.push_back(carry);
+    }
+
+    // One count per feasible start slot, from 0 to `CountSlots - duration`.
+    std::vector<int> counts() const {
+        std::vector<int> counts(CountSlots - this->duration + 1, 0);
+        for (size_t p { 0 }; p < this->planes.size(); ++p) {
+            for (size_t s { 0 }; s < counts.size(); ++s) {
+                counts[s] += static_cast<int>((this->planes[p][s / 64] >> (s % 64)) & 1) << p;
+            }
+        }
+
+        return counts;
+    }
+
+ private:
+    const int duration;
+    std::vector<Slots> planes { };
+
+    static Slots shiftRight(const Slots &slots, int shift) {
+        Slots result { };
+        const auto words { shift / 64 };
+        const auto bits { shift % 64 };
+        for (size_t i { 0 }; i + words < CountWords; ++i) {
+            result[i] = slots[i + words] >> bits;
+            if (bits != 0 && i + words + 1 < CountWords) {
+                result[i] |= slots[i + words + 1] << (64 - bits);
+            }
+        }
+
+        return result;
+    }
+
+    // Slots `s` such that `s` to `s + duration - 1` are all free, by doubling
+    // the length of the runs found so far.
+    static Slots runStarts(const Slots &slots, int duration) {
+        auto runs { slots };
+        auto length { 1 };
+        while (length < duration) {
+            const auto step { std::min(length, duration - length) };
+            const auto shifted { shiftRight(runs, step) };
+            for (size_t i { 0 }; i < CountWords; ++i) {
+                runs[i] &= shifted[i];
+            }
+
+            length += step;
+        }
+
+        return runs;
+    }
+};
+
+// Answers "which start slot suits most of these attendees" for a subset of
+// the users, instead of one query per candidate event. The users stay in
+// their database layout, and only the attendees are converted.
+class Query {
+ public:
+    // Users are `SlotsLength`-byte records, read in place; they must outlive
+    // the query.
+    Query(const unsigned char *users, size_t count) : users { users, count * SlotsLength } { }
+
+    static Slots bytesToSlots(const unsigned char *data) {
+        Slots slots { };
+        for (size_t i { 0 }; i < SlotsLength; ++i) {
+            const auto bit { (SlotsLength - 1 - i) * 8 };
+            slots[bit / 64] |= static_cast<uint64_t>(data[i]) << (bit % 64);
+        }
+
+        return slots;
+    }
+
+    size_t size() const {
+        return this->users.size() / SlotsLength;
+    }
+
+    // Counts, for every feasible start slot, the attendees free for the whole
+    // `duration` slots from there. Attendees are a bitmap over the users:
+    // bit `i % 8` of byte `i / 8` selects the `i`-th user.
+    std::vector<int> starts(std::span<const unsigned char> attendees, int duration) const {
+        Counter counter { duration };
+        const auto count { this->size() };
+        for (size_t byte { 0 }; byte < attendees.size(); ++byte) {
+            for (unsigned bits { attendees[byte] }; bits != 0; bits &= bits - 1) {
+                const auto index { byte * 8 + std::countr_zero(bits) };
+                if (index >= count) {
+                    break;
+                }
+
+                counter.add(bytesToSlots(this->users.data() + index * SlotsLength));
+            }
+        }
+
+        return counter.counts();
+    }
+
+    // The `k` start slots with the most attendees, earliest first on ties.
+    static std::vector<Start> best(const std::vector<int> &counts, size_t k) {
+        std::vector<Start> starts(counts.size());
+        for (size_t s { 0 }; s < counts.size(); ++s) {
+            starts[s] = { static_cast<int>(s), counts[s] };
+        }
+
+        const auto top { std::min(k, starts.size()) };
+        std::ranges::partial_sort(starts, starts.begin() + top, [](const Start &a, const Start &b) {
+            return a.count != b.count ? a.count > b.count : a.slot < b.slot;
+        });
+
+        starts.resize(top);
+        return starts;
+    }
+
+ private:
+    const std::span<const unsigned char> users;
+};
+}
@@ -1,3 +1,5 @@
+#pragma once
+
 #include <algorithm>
 #include <chrono>
 #include <emmintrin.h>
@@ -9,12 +11,16 @@
 #include <thread>
 #include <future>
 
+#include "../trace.h"
+
 namespace threads {
 class Slots {
  public:
-    explicit Slots(const pqxx::binarystring &blob) :
-        head { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(blob.data())) },
-        tail { _mm_loadu_si128(reinterpret_cast<const __m128i*>(blob.data() + 26)) } { }
+    explicit Slots(const pqxx::binarystring &blob) : Slots { blob.data() } { }
+
+    explicit Slots(const unsigned char *data) :
+        head { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)) },
+        tail { _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 26)) } { }
 
     bool matches(const Slots &other) const {
         return
@@ -41,6 +47,14 @@ class Slots {
 
 class Matcher {
  public:
+    static constexpr auto DefaultPages { 10 };
+
+    // Every page opens its own connection, so this stays well under the
+    // default `max_connections` of PostgreSQL.
+    static constexpr auto MaxPages { 32 };
+
+    explicit Matcher(int pages = DefaultPages) : pages { std::clamp(pages, 1, MaxPages) } { }
+
     std::map<int, int> match(pqxx::work &db) {
         const auto startUsers { std::chrono::steady_clock::now() };
         const auto users { loadUsers(db) };
@@ -52,19 +66,23 @@ class Matcher {
         const auto startMatch { std::chrono::steady_clock::now() };
         std::map<int, int> counters { };
 
-        constexpr auto Users { 5000 };
-        constexpr auto Pages { 10 };
-        constexpr auto PageSize { Users / Pages };
-        static_assert(Users % Pages == 0);
+        const auto countEvents { db.exec("select count(*) from events")[0][0].as<int>() };
+        const auto pageSize { std::max(1, (countEvents + this->pages - 1) / this->pages) };
 
         std::vector<std::future<std::map<int, int>>> tasks { };
 
-        for (auto page { 0 }; page < Pages; ++page) {
-            tasks.emplace_back(std::async(std::launch::async, matchPage, &users, page * PageSize, PageSize));
+        for (auto page { 0 }; page < this->pages; ++page) {
+            tasks.emplace_back(std::async(std::launch::async, matchPage, &users, page * pageSize, pageSize));
         }
 
         for (auto &task : tasks) {
-            const auto c { task.get() };
+            std::map<int, int> c { };
+            {
+                TRACE_SCOPE("wait page");
+                c = task.get();
+            }
+
+            TRACE_SCOPE("reduce");
             counters.insert(c.begin(), c.end());
         }
 
@@ -74,16 +92,43 @@ class Matcher {
         return counters;
     }
 
- private:
-    static constexpr size_t SlotsLength { 42 };
+    static Slots byteaToSlots(pqxx::field const &field)
+    {
+        pqxx::binarystring blob { field };
+        assert(blob.size() - 1 == SlotsLength);
+        return Slots { blob };
+    }
 
-    static std::map<int, int> matchPage(const std::vector<Slots> *users, int skip, int take) {
-        pqxx::connection connection { "dbname=schedules" };
-        pqxx::work db { connection };
+    static Slots bytesToSlots(const unsigned char *data) {
+        return Slots { data };
+    }
+
+    static int matches(const Slots &eventSlots, const std::vector<Slots> &users) {
+        auto counter { 0 };
 
-        connection.prepare("p", "select id, slots from events offset $1 limit $2");
+        for (const auto &userSlots : users) {
+            if (eventSlots.matches(userSlots)) {
+                ++counter;
+            }
+        }
 
-        const auto result { db.exec_prepared("p", skip, take) };
+        return counter;
+    }
+
+    // Loads the page of events through a connection of its own, and matches
+    // them against the users.
+    static std::map<int, int> matchPage(const std::vector<Slots> *users, int skip, int take) {
+        pqxx::result result { };
+        {
+            TRACE_SCOPE("load events page");
+            pqxx::connection connection { "dbname=schedules" };
+            pqxx::work db { connection };
+
+            connection.prepare("p", "select id, slots from events offset $1 limit $2");
+            result = db.exec_prepared("p", skip, take);
+        }
+
+        TRACE_SCOPE("match page");
         std::map<int, int> counters { };
         for (auto row : result) {
             const auto eventId { row[0].as<int>() };
@@ -94,33 +139,25 @@ class Matcher {
         return counters;
     }
 
-    static Slots byteaToSlots(pqxx::field const &field)
-    {
-        pqxx::binarystring blob { field };
-        assert(blob.size() - 1 == SlotsLength);
-        return Slots { blob };
-    }
+ private:
+    static constexpr size_t SlotsLength { 42 };
+
+    const int pages;
 
     static std::vector<Slots> loadUsers(pqxx::work &db) {
         std::vector<Slots> slots { };
-        pqxx::result result { db.exec("select slots from users;") };
+        pqxx::result result { };
+        {
+            TRACE_SCOPE("load users");
+            result = db.exec("select slots from users;");
+        }
+
+        TRACE_SCOPE("convert users");
         for (auto row : result) {
             slots.push_back(byteaToSlots(row[0]));
         }
 
         return slots;
     }
-
-    static int matches(const Slots &eventSlots, const std::vector<Slots> &users) {
-        auto counter { 0 };
-
-        for (const auto &userSlots : users) {
-            if (eventSlots.matches(userSlots)) {
-                ++counter;
-            }
-        }
-
-        return counter;
-    }
 };
 }
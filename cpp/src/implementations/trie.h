@@ -0,0 +1,235 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <pqxx/pqxx>
+#include <utility>
+#include <vector>
+
+#include "../trace.h"
+#include "avx2.h"
+
+namespace trie {
+constexpr size_t SlotsLength { 42 };
+using Slots = std::array<unsigned char, SlotsLength>;
+
+// Users sorted by slots, with a trie over their bytes. Every node covers the
+// contiguous range of users sharing a prefix, so a query adds whole ranges as
+// soon as the event has no slots left past that prefix, and skips the ranges
+// whose next byte lacks a slot of the event.
+class Index {
+ public:
+    explicit Index(std::vector<Slots> slots) : users { std::move(slots) } {
+        TRACE_SCOPE("build trie");
+        std::ranges::sort(this->users);
+        this->build();
+    }
+
+    int matches(const Slots &eventSlots) const {
+        auto last { static_cast<int>(SlotsLength) - 1 };
+        while (last >= 0 && eventSlots[last] == 0) {
+            --last;
+        }
+
+        const avx2::Slots event { eventSlots.data() };
+        auto counter { 0 };
+
+        // The siblings still to visit at every depth; the nodes at depth `d`
+        // are known to match the first `d - 1` bytes of the event, so a
+        // walk never holds more than one range per byte.
+        std::array<Range, SlotsLength + 1> pending { };
+        pending[0] = { 0, 1 };
+        auto depth { 0 };
+
+        while (depth >= 0) {
+            auto &range { pending[depth] };
+            if (range.next == range.end) {
+                --depth;
+                continue;
+            }
+
+            const auto &node { this->nodes[range.next++] };
+            if (depth > 0 && (node.byte & eventSlots[depth - 1]) != eventSlots[depth - 1]) {
+                continue;
+            }
+
+            if (depth > last) {
+                counter += node.count;
+                continue;
+            }
+
+            if (node.children == 0) {
+                counter += this->matchesRange(event, node.begin, node.count);
+                continue;
+            }
+
+            pending[++depth] = { node.firstChild, node.firstChild + node.children };
+        }
+
+        return counter;
+    }
+
+    size_t size() const {
+        return this->users.size();
+    }
+
+    size_t countNodes() const {
+        return this->nodes.size();
+    }
+
+    size_t memory() const {
+        return this->users.capacity() * sizeof(Slots) + this->nodes.capacity() * sizeof(Node);
+    }
+
+ private:
+    // A node is split only if its children average at least that many
+    // users; scanning them is cheaper than visiting smaller nodes.
+    static constexpr uint32_t LeafUsers { 32 };
+
+    struct Node {
+        uint32_t begin;
+        uint32_t count;
+        uint32_t firstChild;
+        uint16_t children;
+        unsigned char byte;
+    };
+
+    struct Range {
+        uint32_t next;
+        uint32_t end;
+    };
+
+    std::vector<Slots> users;
+    std::vector<Node> nodes { };
+
+    // Level by level, so that the children of a node are contiguous and
+    // ordered by byte.
+    void build() {
+        this->nodes.push_back({ 0, static_cast<uint32_t>(this->users.size()), 0, 0, 0 });
+
+        size_t levelBegin { 0 };
+        for (size_t depth { 0 }; depth < SlotsLength && levelBegin < this->nodes.size(); ++depth) {
+            const auto levelEnd { this->nodes.size() };
+            for (auto i { levelBegin }; i < levelEnd; ++i) {
+                const auto begin { this->nodes[i].begin };
+                const auto end { begin + this->nodes[i].count };
+                if (end - begin < 2 * LeafUsers) {
+                    continue;
+                }
+
+                uint32_t children { 1 };
+                for (auto j { begin + 1 }; j < end; ++j) {
+                    children += this->users[j][depth] != this->users[j - 1][depth];
+                }
+
+                if ((end - begin) / children < LeafUsers) {
+                    continue;
+                }
+
+                const auto firstChild { static_cast<uint32_t>(this->nodes.size()) };
+                for (auto first { begin }; first < end; ) {
+                    const auto byte { this->users[first][depth] };
+                    auto next { first + 1 };
+                    while (next < end && this->users[next][depth] == byte) {
+                        ++next;
+                    }
+
+                    this->nodes.push_back({ first, next - first, 0, 0, byte });
+                    first = next;
+                }
+
+                this->nodes[i].firstChild = firstChild;
+                this->nodes[i].children = static_cast<uint16_t>(this->nodes.size() - firstChild);
+            }
+
+            levelBegin = levelEnd;
+        }
+
+        this->nodes.shrink_to_fit();
+    }
+
+    int matchesRange(const avx2::Slots &eventSlots, uint32_t begin, uint32_t count) const {
+        auto counter { 0 };
+        for (auto i { begin }; i < begin + count; ++i) {
+            counter += eventSlots.matches(avx2::Slots { this->users[i].data() });
+        }
+
+        return counter;
+    }
+};
+
+class Matcher {
+ public:
+    std::map<int, int> match(pqxx::work &db) {
+        const auto startUsers { std::chrono::steady_clock::now() };
+        auto users { loadUsers(db) };
+        const auto endUsers { std::chrono::steady_clock::now() };
+        const auto usersDuration { std::chrono::duration_cast<std::chrono::milliseconds>(endUsers - startUsers).count() };
+
+        std::cout << users.size() << " users loaded in " << usersDuration << " ms." << std::endl;
+
+        const auto startIndex { std::chrono::steady_clock::now() };
+        const Index index { std::move(users) };
+        const auto endIndex { std::chrono::steady_clock::now() };
+        const auto indexDuration { std::chrono::duration_cast<std::chrono::milliseconds>(endIndex - startIndex).count() };
+
+        std::cout
+            << "Trie of " << index.countNodes() << " nodes built in " << indexDuration << " ms, using "
+            << index.memory() / 1024 << " KiB." << std::endl;
+
+        const auto startMatch { std::chrono::steady_clock::now() };
+        std::map<int, int> counters { };
+
+        pqxx::result result { };
+        {
+            TRACE_SCOPE("load events");
+            result = db.exec("select id, slots from events");
+        }
+
+        TRACE_SCOPE("match events");
+        for (auto row : result) {
+            const auto eventId { row[0].as<int>() };
+            const auto eventSlots { byteaToSlots(row[1]) };
+            counters[eventId] = index.matches(eventSlots);
+        }
+
+        const auto endMatch { std::chrono::steady_clock::now() };
+        const auto matchDuration { std::chrono::duration_cast<std::chrono::milliseconds>(endMatch - startMatch).count() };
+        std::cout << "Matches computed in " << matchDuration << " ms." << std::endl;
+        return counters;
+    }
+
+    static Slots byteaToSlots(pqxx::field const &field) {
+        pqxx::binarystring blob { field };
+        assert(blob.size() - 1 == SlotsLength);
+        return bytesToSlots(blob.data());
+    }
+
+    static Slots bytesToSlots(const unsigned char *data) {
+        Slots result;
+        std::copy_n(data, SlotsLength, result.begin());
+        return result;
+    }
+
+ private:
+    static std::vector<Slots> loadUsers(pqxx::work &db) {
+        std::vector<Slots> slots { };
+        pqxx::result result { };
+        {
+            TRACE_SCOPE("load users");
+            result = db.exec("select slots from users;");
+        }
+
+        TRACE_SCOPE("convert users");
+        for (auto row : result) {
+            slots.push_back(byteaToSlots(row[0]));
+        }
+
+        return slots;
+    }
+};
+}
@@ -5,13 +5,21 @@
 #include <pqxx/pqxx>
 #include <ranges>
 
+#include "implementations/autotune.h"
 #include "implementations/avx2.h"
 #include "implementations/int64.h"
+#include "implementations/overlap.h"
 #include "implementations/plain.h"
 #include "implementations/sse.h"
 #include "implementations/threads.h"
+#include "implementations/trie.h"
+
+inline std::map<int, int> match(const std::string &type, pqxx::work &db, int pages = threads::Matcher::DefaultPages) {
+    if (type == "auto") {
+        const auto choice { autotune::Tuner().choose(db) };
+        return match(choice.type, db, choice.pages);
+    }
 
-inline std::map<int, int> match(std::string &type, pqxx::work &db) {
     if (type == "plain") {
         return plain::Matcher().match(db);
     }
@@ -25,19 +33,27 @@ inline std::map<int, int> match(std::string &type, pqxx::work &db) {
     }
 
     if (type == "threads") {
-        return threads::Matcher().match(db);
+        return threads::Matcher(pages).match(db);
     }
 
     if (type == "int64") {
         return int64::Matcher().match(db);
     }
 
+    if (type == "overlap") {
+        return overlap::Matcher().match(db);
+    }
+
+    if (type == "trie") {
+        return trie::Matcher().match(db);
+    }
+
     throw std::out_of_range("The specified type is not supported.");
 }
 
 int main(int argc, char* argv[]) {
     if (argc != 2) {
-        std::cerr << "Usage: " << argv[0] << " <type>" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " <plain|sse|avx2|threads|int64|overlap|trie|auto>" << std::endl;
         return 1; // Exit with an error code
     }
 
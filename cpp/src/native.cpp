@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <future>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "implementations/avx2.h"
+#include "implementations/int64.h"
+#include "implementations/overlap.h"
+#include "implementations/plain.h"
+#include "implementations/sse.h"
+#include "implementations/subset.h"
+#include "implementations/threads.h"
+#include "native.h"
+#include "trace.h"
+
+namespace {
+template <typename Matcher>
+auto toSlots(const uint8_t *data, size_t count) {
+    TRACE_SCOPE("convert users");
+    std::vector<decltype(Matcher::bytesToSlots(data))> slots { };
+    slots.reserve(count);
+    for (size_t i { 0 }; i < count; ++i) {
+        slots.push_back(Matcher::bytesToSlots(data + i * SCHEDULES_SLOTS_LENGTH));
+    }
+
+    return slots;
+}
+
+template <typename Matcher>
+void count(const uint8_t *usersData, size_t countUsers, const uint8_t *eventsData, size_t countEvents, int32_t *counts) {
+    const auto users { toSlots<Matcher>(usersData, countUsers) };
+
+    TRACE_SCOPE("match events");
+    for (size_t i { 0 }; i < countEvents; ++i) {
+        const auto eventSlots { Matcher::bytesToSlots(eventsData + i * SCHEDULES_SLOTS_LENGTH) };
+        counts[i] = Matcher::matches(eventSlots, users);
+    }
+}
+
+// Same pages as `threads::Matcher`, but the events are already in memory, so
+// every page reads its own part of the buffer instead of querying the database.
+void countThreads(const uint8_t *usersData, size_t countUsers, const uint8_t *eventsData, size_t countEvents, int32_t *counts) {
+    const auto users { toSlots<threads::Matcher>(usersData, countUsers) };
+    const auto pages { static_cast<size_t>(std::max(1u, std::thread::hardware_concurrency())) };
+    const auto pageSize { (countEvents + pages - 1) / pages };
+
+    std::vector<std::future<void>> tasks { };
+    for (size_t skip { 0 }; skip < countEvents; skip += pageSize) {
+        tasks.emplace_back(std::async(std::launch::async, [&, skip] {
+            TRACE_SCOPE("match page");
+            const auto last { std::min(skip + pageSize, countEvents) };
+            for (auto i { skip }; i < last; ++i) {
+                const auto eventSlots { threads::Matcher::bytesToSlots(eventsData + i * SCHEDULES_SLOTS_LENGTH) };
+                counts[i] = threads::Matcher::matches(eventSlots, users);
+            }
+        }));
+    }
+
+    for (auto &task : tasks) {
+        task.get();
+    }
+}
+}
+
+extern "C" int schedules_count(
+    const char *type,
+    const uint8_t *users,
+    size_t countUsers,
+    const uint8_t *events,
+    size_t countEvents,
+    int32_t *counts) {
+    try {
+        const std::string name { type };
+
+        if (name == "plain") {
+            count<plain::Matcher>(users, countUsers, events, countEvents, counts);
+        } else if (name == "sse") {
+            count<sse::Matcher>(users, countUsers, events, countEvents, counts);
+        } else if (name == "avx2") {
+            count<avx2::Matcher>(users, countUsers, events, countEvents, counts);
+        } else if (name == "int64") {
+            count<int64::Matcher>(users, countUsers, events, countEvents, counts);
+        } else if (name == "threads") {
+            countThreads(users, countUsers, events, countEvents, counts);
+        } else {
+            return 1;
+        }
+
+        return 0;
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 2;
+    }
+}
+
+extern "C" int schedules_overlaps(
+    const uint8_t *users,
+    size_t countUsers,
+    const uint8_t *events,
+    size_t countEvents,
+    int32_t *histograms) {
+    constexpr auto HistogramLength { SCHEDULES_SLOTS_LENGTH * 8 + 1 };
+
+    try {
+        const auto slots { toSlots<overlap::Matcher>(users, countUsers) };
+        for (size_t i { 0 }; i < countEvents; ++i) {
+            const auto eventSlots { overlap::Matcher::bytesToSlots(events + i * SCHEDULES_SLOTS_LENGTH) };
+            const auto histogram { overlap::Matcher::histogram(eventSlots, slots) };
+            const auto row { histograms + i * HistogramLength };
+            std::fill_n(row, HistogramLength, 0);
+            std::ranges::copy(histogram, row);
+        }
+
+        return 0;
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 2;
+    }
+}
+
+extern "C" int schedules_scores(
+    const uint8_t *users,
+    size_t countUsers,
+    const uint8_t *event,
+    int32_t *scores) {
+    try {
+        const auto slots { toSlots<overlap::Matcher>(users, countUsers) };
+        const auto eventSlots { overlap::Matcher::bytesToSlots(event) };
+        std::ranges::copy(overlap::Matcher::scores(eventSlots, slots), scores);
+        return 0;
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 2;
+    }
+}
+
+extern "C" int schedules_at_least(
+    const uint8_t *users,
+    size_t countUsers,
+    const uint8_t *events,
+    size_t countEvents,
+    double ratio,
+    int32_t *counts) {
+    if (!(ratio >= 0 && ratio <= 1)) {
+        return 1;
+    }
+
+    try {
+        const auto slots { toSlots<overlap::Matcher>(users, countUsers) };
+        for (size_t i { 0 }; i < countEvents; ++i) {
+            const auto eventSlots { overlap::Matcher::bytesToSlots(events + i * SCHEDULES_SLOTS_LENGTH) };
+            counts[i] = overlap::Matcher::atLeast(overlap::Matcher::histogram(eventSlots, slots), ratio);
+        }
+
+        return 0;
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 2;
+    }
+}
+
+extern "C" int schedules_starts(
+    const uint8_t *users,
+    size_t countUsers,
+    const uint8_t *attendees,
+    int duration,
+    int32_t *counts) {
+    if (duration < 1 || static_cast<size_t>(duration) > subset::CountSlots) {
+        return 1;
+    }
+
+    try {
+        const subset::Query query { users, countUsers };
+        std::ranges::copy(query.starts({ attendees, (countUsers + 7) / 8 }, duration), counts);
+        return 0;
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 2;
+    }
+}
+
+extern "C" int schedules_best_starts(
+    const uint8_t *users,
+    size_t countUsers,
+    const uint8_t *attendees,
+    int duration,
+    size_t k,
+    int32_t *slots,
+    int32_t *counts) {
+    if (duration < 1 || static_cast<size_t>(duration) > subset::CountSlots) {
+        return 1;
+    }
+
+    try {
+        const subset::Query query { users, countUsers };
+        const auto best { subset::Query::best(query.starts({ attendees, (countUsers + 7) / 8 }, duration), k) };
+        for (size_t i { 0 }; i < best.size(); ++i) {
+            slots[i] = best[i].slot;
+            counts[i] = best[i].count;
+        }
+
+        return 0;
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 2;
+    }
+}
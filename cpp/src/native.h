@@ -0,0 +1,100 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Length, in bytes, of the slots of a single user or event.
+#define SCHEDULES_SLOTS_LENGTH 42
+
+// Counts, for every event, the users available for all its slots.
+//
+// Users and events are contiguous arrays of `SCHEDULES_SLOTS_LENGTH`-byte
+// records, laid out exactly as the `slots` columns of the database. The
+// buffers are read in place; `counts` receives one value per event.
+//
+// `type` is one of `plain`, `sse`, `avx2`, `int64` or `threads`. Returns zero
+// on success, and a non-zero value if the type is not supported or the
+// computation failed.
+int schedules_count(
+    const char *type,
+    const uint8_t *users,
+    size_t countUsers,
+    const uint8_t *events,
+    size_t countEvents,
+    int32_t *counts);
+
+// Computes, for every event, the histogram of the number of slots users share
+// with it.
+//
+// Users and events are laid out as for `schedules_count`. `histograms`
+// receives `SCHEDULES_SLOTS_LENGTH * 8 + 1` values per event: the number of
+// users sharing exactly zero, one, two... slots with the event. Returns zero
+// on success, and a non-zero value if the computation failed.
+int schedules_overlaps(
+    const uint8_t *users,
+    size_t countUsers,
+    const uint8_t *events,
+    size_t countEvents,
+    int32_t *histograms);
+
+// Computes the number of slots every user shares with one event, to rank the
+// users by availability.
+//
+// Users are laid out as for `schedules_count`, and `event` is one record of
+// `SCHEDULES_SLOTS_LENGTH` bytes. `scores` receives one value per user, in the
+// order of the users. Returns zero on success, and a non-zero value if the
+// computation failed.
+int schedules_scores(
+    const uint8_t *users,
+    size_t countUsers,
+    const uint8_t *event,
+    int32_t *scores);
+
+// Counts, for every event, the users free for at least `ratio` of its slots,
+// such as 0.8 for "free for at least 80% of the workshop".
+//
+// Users and events are laid out as for `schedules_count`. `counts` receives
+// one value per event. Returns zero on success, and a non-zero value if the
+// ratio is not between zero and one or the computation failed.
+int schedules_at_least(
+    const uint8_t *users,
+    size_t countUsers,
+    const uint8_t *events,
+    size_t countEvents,
+    double ratio,
+    int32_t *counts);
+
+// Counts, for every start slot from zero to `SCHEDULES_SLOTS_LENGTH * 8 -
+// duration`, the attendees free for `duration` consecutive slots from there.
+//
+// Users are laid out as for `schedules_count`. Attendees are a bitmap over
+// them: bit `i % 8` of byte `i / 8` selects the `i`-th user; only the selected
+// users are read. `counts` receives one value per start slot. Returns zero on
+// success, and a non-zero value if the duration is out of range or the
+// computation failed.
+int schedules_starts(
+    const uint8_t *users,
+    size_t countUsers,
+    const uint8_t *attendees,
+    int duration,
+    int32_t *counts);
+
+// Same as `schedules_starts`, but keeps only the `k` start slots with the most
+// attendees, earliest first on ties. `slots` and `counts` receive the start
+// slots and their counts; there are fewer than `k` if fewer slots are feasible.
+int schedules_best_starts(
+    const uint8_t *users,
+    size_t countUsers,
+    const uint8_t *attendees,
+    int duration,
+    size_t k,
+    int32_t *slots,
+    int32_t *counts);
+
+#ifdef __cplusplus
+}
+#endif
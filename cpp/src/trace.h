@@ -0,0 +1,176 @@
+#pragma once
+
+// Per-thread traces of the time spent loading, converting and matching, dumped
+// on exit as a Chrome trace, to be opened in Perfetto or `chrome://tracing`.
+//
+// Tracing exists only when compiled with `SCHEDULES_TRACE` (the CMake option
+// of the same name); otherwise `TRACE_SCOPE` expands to nothing.
+
+#ifdef SCHEDULES_TRACE
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <x86intrin.h>
+
+namespace trace {
+struct Event {
+    const char *name;
+    uint64_t begin;
+    uint64_t end;
+};
+
+// Written only by the thread holding it, without locks; once full, the oldest
+// events are overwritten.
+class Buffer {
+ public:
+    explicit Buffer(int thread) : thread { thread } { }
+
+    void record(const char *name, uint64_t begin, uint64_t end) {
+        const auto position { this->written.load(std::memory_order_relaxed) };
+        this->events[position % Capacity] = { name, begin, end };
+        this->written.store(position + 1, std::memory_order_release);
+    }
+
+    template <typename Callback>
+    void forEach(Callback callback) const {
+        const auto written { this->written.load(std::memory_order_acquire) };
+        const auto first { written > Capacity ? written - Capacity : 0 };
+        for (auto i { first }; i < written; ++i) {
+            callback(this->thread, this->events[i % Capacity]);
+        }
+    }
+
+ private:
+    static constexpr size_t Capacity { 1 << 12 };
+
+    const int thread;
+    std::array<Event, Capacity> events { };
+    std::atomic<size_t> written { 0 };
+};
+
+class Registry {
+ public:
+    static Registry &instance() {
+        static Registry registry { };
+        return registry;
+    }
+
+    // The buffer of the calling thread. A thread gives its buffer back when it
+    // exits, and the next thread to start tracing takes it over, so that
+    // short-lived threads do not add a buffer each; the `tid` of the trace is
+    // therefore a track shared by threads that never overlap.
+    Buffer &local() {
+        thread_local const Lease lease { *this };
+        return lease.buffer;
+    }
+
+    ~Registry() {
+        const auto path { std::getenv("SCHEDULES_TRACE_FILE") };
+        std::ofstream file { path == nullptr ? "schedules-trace.json" : path };
+
+        // The time stamp counter is converted to microseconds using the clock
+        // elapsed since the registry was created.
+        const auto ticks { static_cast<double>(__rdtsc() - this->startTicks) };
+        const auto elapsed { std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - this->startClock).count() };
+        const auto ticksPerMicrosecond { elapsed > 0 ? ticks / elapsed : 1.0 };
+
+        const std::lock_guard lock { this->mutex };
+        auto first { true };
+        file << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+        for (const auto &buffer : this->buffers) {
+            buffer->forEach([&](int thread, const Event &event) {
+                file
+                    << (first ? "\n" : ",\n")
+                    << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread
+                    << ",\"ts\":" << static_cast<double>(event.begin - this->startTicks) / ticksPerMicrosecond
+                    << ",\"dur\":" << static_cast<double>(event.end - event.begin) / ticksPerMicrosecond << "}";
+                first = false;
+            });
+        }
+
+        file << "\n]}" << std::endl;
+
+        if (!file) {
+            std::cerr << "Cannot write the trace." << std::endl;
+        }
+    }
+
+ private:
+    class Lease {
+     public:
+        explicit Lease(Registry &registry) : registry { registry }, buffer { registry.acquire() } { }
+
+        Lease(const Lease &) = delete;
+        Lease &operator=(const Lease &) = delete;
+
+        ~Lease() {
+            this->registry.release(this->buffer);
+        }
+
+        Registry &registry;
+        Buffer &buffer;
+    };
+
+    Registry() : startClock { std::chrono::steady_clock::now() }, startTicks { __rdtsc() } { }
+
+    Buffer &acquire() {
+        const std::lock_guard lock { this->mutex };
+        if (!this->available.empty()) {
+            const auto buffer { this->available.back() };
+            this->available.pop_back();
+            return *buffer;
+        }
+
+        this->buffers.push_back(std::make_unique<Buffer>(static_cast<int>(this->buffers.size())));
+        return *this->buffers.back();
+    }
+
+    void release(Buffer &buffer) {
+        const std::lock_guard lock { this->mutex };
+        this->available.push_back(&buffer);
+    }
+
+    const std::chrono::steady_clock::time_point startClock;
+    const uint64_t startTicks;
+    std::mutex mutex { };
+    std::vector<std::unique_ptr<Buffer>> buffers { };
+    std::vector<Buffer*> available { };
+};
+
+// Records the time between its construction and its destruction.
+class Scope {
+ public:
+    explicit Scope(const char *name) : buffer { Registry::instance().local() }, name { name }, begin { __rdtsc() } { }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+    ~Scope() {
+        this->buffer.record(this->name, this->begin, __rdtsc());
+    }
+
+ private:
+    Buffer &buffer;
+    const char *name;
+    const uint64_t begin;
+};
+}
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) const trace::Scope TRACE_CONCAT(traceScope, __LINE__) { name }
+
+#else
+
+#define TRACE_SCOPE(name)
+
+#endif
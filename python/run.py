@@ -19,6 +19,7 @@ if __name__ == '__main__':
         'mapreduce': schedules.count_map_reduce,
         'mapreduce-file': schedules.count_map_reduce_file,
         'indb': schedules.count_in_database,
+        'native': schedules.count_native,
     }[run_type]
 
     with psycopg.connect(conninfo, connect_timeout=2) as connection:
@@ -0,0 +1,257 @@
+#!/usr/bin/env python
+
+import ctypes
+import numpy
+import os
+import pathlib
+import typing
+
+
+SLOTS_LENGTH = 42
+
+_library = None
+
+
+def _library_path() -> pathlib.Path:
+    # Built by `cpp/build` next to the `schedules` binary, unless overridden.
+    path = os.environ.get('SCHEDULES_NATIVE_LIBRARY')
+    if path:
+        return pathlib.Path(path)
+
+    return pathlib.Path(__file__).resolve().parents[2] / 'cpp' / 'bin' / 'libschedules_native.so'
+
+
+def _load() -> ctypes.CDLL:
+    global _library
+    if _library is None:
+        library = ctypes.CDLL(str(_library_path()))
+        library.schedules_count.argtypes = [
+            ctypes.c_char_p,
+            ctypes.c_void_p,
+            ctypes.c_size_t,
+            ctypes.c_void_p,
+            ctypes.c_size_t,
+            ctypes.c_void_p,
+        ]
+        library.schedules_count.restype = ctypes.c_int
+        library.schedules_overlaps.argtypes = [
+            ctypes.c_void_p,
+            ctypes.c_size_t,
+            ctypes.c_void_p,
+            ctypes.c_size_t,
+            ctypes.c_void_p,
+        ]
+        library.schedules_overlaps.restype = ctypes.c_int
+        library.schedules_scores.argtypes = [
+            ctypes.c_void_p,
+            ctypes.c_size_t,
+            ctypes.c_void_p,
+            ctypes.c_void_p,
+        ]
+        library.schedules_scores.restype = ctypes.c_int
+        library.schedules_at_least.argtypes = [
+            ctypes.c_void_p,
+            ctypes.c_size_t,
+            ctypes.c_void_p,
+            ctypes.c_size_t,
+            ctypes.c_double,
+            ctypes.c_void_p,
+        ]
+        library.schedules_at_least.restype = ctypes.c_int
+        library.schedules_starts.argtypes = [
+            ctypes.c_void_p,
+            ctypes.c_size_t,
+            ctypes.c_void_p,
+            ctypes.c_int,
+            ctypes.c_void_p,
+        ]
+        library.schedules_starts.restype = ctypes.c_int
+        library.schedules_best_starts.argtypes = [
+            ctypes.c_void_p,
+            ctypes.c_size_t,
+            ctypes.c_void_p,
+            ctypes.c_int,
+            ctypes.c_size_t,
+            ctypes.c_void_p,
+            ctypes.c_void_p,
+        ]
+        library.schedules_best_starts.restype = ctypes.c_int
+        _library = library
+
+    return _library
+
+
+def _as_slots(buffer: typing.Any) -> numpy.ndarray:
+    # `numpy.frombuffer` goes through the buffer protocol, so `bytes`,
+    # `bytearray`, `memoryview` and contiguous `uint8` arrays are not copied.
+    slots = numpy.frombuffer(buffer, dtype=numpy.uint8)
+    if slots.size % SLOTS_LENGTH != 0:
+        raise ValueError(f'The buffer size should be a multiple of {SLOTS_LENGTH} bytes.')
+
+    return slots
+
+
+def count(users: typing.Any, events: typing.Any, engine: str = 'avx2') -> numpy.ndarray:
+    users_slots = _as_slots(users)
+    events_slots = _as_slots(events)
+    count_events = events_slots.size // SLOTS_LENGTH
+    counts = numpy.zeros(count_events, dtype=numpy.int32)
+
+    status = _load().schedules_count(
+        engine.encode(),
+        users_slots.ctypes.data,
+        users_slots.size // SLOTS_LENGTH,
+        events_slots.ctypes.data,
+        count_events,
+        counts.ctypes.data)
+
+    if status != 0:
+        raise ValueError(f'The native engine "{engine}" failed with status {status}.')
+
+    return counts
+
+
+def overlaps(users: typing.Any, events: typing.Any) -> numpy.ndarray:
+    """Histograms of the number of slots users share with every event.
+
+    Row `e`, column `i` is the number of users sharing exactly `i` slots with
+    event `e`. The users available for the whole event are in the column equal
+    to its number of slots; the columns past it are zero.
+    """
+    users_slots = _as_slots(users)
+    events_slots = _as_slots(events)
+    count_events = events_slots.size // SLOTS_LENGTH
+    histograms = numpy.zeros((count_events, SLOTS_LENGTH * 8 + 1), dtype=numpy.int32)
+
+    status = _load().schedules_overlaps(
+        users_slots.ctypes.data,
+        users_slots.size // SLOTS_LENGTH,
+        events_slots.ctypes.data,
+        count_events,
+        histograms.ctypes.data)
+
+    if status != 0:
+        raise ValueError(f'The overlaps failed with status {status}.')
+
+    return histograms
+
+
+def scores(users: typing.Any, event: typing.Any) -> numpy.ndarray:
+    """Number of slots every user shares with `event`, in the order of the users.
+
+    `numpy.argsort(-scores(users, event), kind='stable')` ranks the users from
+    the most to the least available for the event.
+    """
+    users_slots = _as_slots(users)
+    event_slots = _as_slots(event)
+    if event_slots.size != SLOTS_LENGTH:
+        raise ValueError(f'The event should be {SLOTS_LENGTH} bytes.')
+
+    count_users = users_slots.size // SLOTS_LENGTH
+    user_scores = numpy.zeros(count_users, dtype=numpy.int32)
+
+    status = _load().schedules_scores(
+        users_slots.ctypes.data,
+        count_users,
+        event_slots.ctypes.data,
+        user_scores.ctypes.data)
+
+    if status != 0:
+        raise ValueError(f'The scores failed with status {status}.')
+
+    return user_scores
+
+
+def at_least(users: typing.Any, events: typing.Any, ratio: float) -> numpy.ndarray:
+    """Counts, for every event, the users free for at least `ratio` of its slots.
+
+    A `ratio` of 0.8 counts the users free for at least 80% of the event, and
+    a `ratio` of 1 the users free for all of it, like `count`.
+    """
+    if not 0 <= ratio <= 1:
+        raise ValueError('The ratio should be between 0 and 1.')
+
+    users_slots = _as_slots(users)
+    events_slots = _as_slots(events)
+    count_events = events_slots.size // SLOTS_LENGTH
+    counts = numpy.zeros(count_events, dtype=numpy.int32)
+
+    status = _load().schedules_at_least(
+        users_slots.ctypes.data,
+        users_slots.size // SLOTS_LENGTH,
+        events_slots.ctypes.data,
+        count_events,
+        ratio,
+        counts.ctypes.data)
+
+    if status != 0:
+        raise ValueError(f'The at-least counts failed with status {status}.')
+
+    return counts
+
+
+def _as_attendees(attendees: typing.Any, count_users: int) -> numpy.ndarray:
+    selection = numpy.asarray(attendees)
+    if selection.dtype == numpy.bool_:
+        selection = numpy.packbits(selection, bitorder='little')
+    elif selection.dtype != numpy.uint8:
+        raise ValueError('The attendees should be a boolean array, or a uint8 bitmap from numpy.packbits.')
+
+    selection = numpy.ascontiguousarray(selection.ravel())
+    size = (count_users + 7) // 8
+    if selection.size < size:
+        selection = numpy.concatenate([selection, numpy.zeros(size - selection.size, dtype=numpy.uint8)])
+
+    return selection
+
+
+def starts(
+        users: typing.Any,
+        attendees: typing.Any,
+        duration: int,
+        top: int | None = None) -> numpy.ndarray | tuple[numpy.ndarray, numpy.ndarray]:
+    """Counts the attendees free for `duration` slots from every start slot.
+
+    `attendees` selects users by position, either as a boolean array or as a
+    `uint8` bitmap packed with `numpy.packbits(..., bitorder='little')`. When
+    `top` is given, returns the best `top` start slots and their counts
+    instead, earliest first on ties.
+    """
+    users_slots = _as_slots(users)
+    count_users = users_slots.size // SLOTS_LENGTH
+    selection = _as_attendees(attendees, count_users)
+
+    if not 1 <= duration <= SLOTS_LENGTH * 8:
+        raise ValueError(f'The duration should be between 1 and {SLOTS_LENGTH * 8} slots.')
+
+    size = SLOTS_LENGTH * 8 - duration + 1
+    if top is None:
+        counts = numpy.zeros(size, dtype=numpy.int32)
+        status = _load().schedules_starts(
+            users_slots.ctypes.data,
+            count_users,
+            selection.ctypes.data,
+            duration,
+            counts.ctypes.data)
+
+        if status != 0:
+            raise ValueError(f'The start slots failed with status {status}.')
+
+        return counts
+
+    k = min(max(top, 0), size)
+    slots = numpy.zeros(k, dtype=numpy.int32)
+    counts = numpy.zeros(k, dtype=numpy.int32)
+    status = _load().schedules_best_starts(
+        users_slots.ctypes.data,
+        count_users,
+        selection.ctypes.data,
+        duration,
+        k,
+        slots.ctypes.data,
+        counts.ctypes.data)
+
+    if status != 0:
+        raise ValueError(f'The start slots failed with status {status}.')
+
+    return slots, counts
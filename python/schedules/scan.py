@@ -11,6 +11,8 @@ import psycopg
 import time
 import typing
 
+from . import native
+
 
 type DatabaseConnection = psycopg.connection.Connection
 conninfo = 'dbname=schedules'
@@ -185,3 +187,16 @@ group by events.id
         cursor.execute(query)
         return {row[0]: row[1] for row in cursor.fetchall()}
 
+
+def count_native(connection: DatabaseConnection) -> dict[int, int]:
+    with connection.cursor() as cursor:
+        cursor.execute('select slots from users order by id')
+        users_slots = b''.join(row[0] for row in cursor)
+
+        cursor.execute('select id, slots from events order by id')
+        rows = cursor.fetchall()
+
+    events_ids = [row[0] for row in rows]
+    events_slots = b''.join(row[1] for row in rows)
+    counts = native.count(users_slots, events_slots)
+    return dict(zip(events_ids, counts.tolist()))
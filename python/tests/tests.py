@@ -35,3 +35,64 @@ class Tests(unittest.TestCase):
 
         expected = {1: 0}
         self.assertEqual(expected, actual)
+
+    def test_count_native_when_event_matches_user(self):
+        with psycopg.connect(conninfo, connect_timeout=2) as connection:
+            schedules.create_u(connection, 0b00101101)
+            schedules.create_e(connection, 0b00001100)
+            actual = schedules.count_native(connection)
+
+        expected = {1: 1}
+        self.assertEqual(expected, actual)
+
+    def test_count_native_when_event_does_not_match_user(self):
+        with psycopg.connect(conninfo, connect_timeout=2) as connection:
+            schedules.create_u(connection, 0b00101101)
+            schedules.create_e(connection, 0b00011000)
+            actual = schedules.count_native(connection)
+
+        expected = {1: 0}
+        self.assertEqual(expected, actual)
+
+    def test_native_starts_counts_attendees_only(self):
+        users = b''.join(slots.to_bytes(42) for slots in [0b0111100, 0b0011110, 0b1111111])
+        attendees = [True, True, False]
+        actual = schedules.native.starts(users, attendees, 3)
+
+        self.assertEqual([0, 1, 2, 1, 0], list(actual[:5]))
+
+        slots, counts = schedules.native.starts(users, attendees, 3, top=2)
+        self.assertEqual([2, 1], list(slots))
+        self.assertEqual([2, 1], list(counts))
+
+    def test_native_starts_rejects_unpacked_integers(self):
+        users = b''.join(slots.to_bytes(42) for slots in [0b0111100, 0b0011110, 0b1111111])
+        with self.assertRaises(ValueError):
+            schedules.native.starts(users, [1, 0, 1], 3)
+
+    def test_native_overlaps_counts_shared_slots(self):
+        users = b''.join(slots.to_bytes(42) for slots in [0b0111, 0b0101, 0b1000])
+        events = (0b0111).to_bytes(42)
+        actual = schedules.native.overlaps(users, events)
+
+        self.assertEqual([1, 0, 1, 1], list(actual[0][:4]))
+
+    def test_native_scores_counts_shared_slots_per_user(self):
+        users = b''.join(slots.to_bytes(42) for slots in [0b0111, 0b0101, 0b1000])
+        event = (0b0111).to_bytes(42)
+
+        self.assertEqual([3, 2, 0], list(schedules.native.scores(users, event)))
+
+    def test_native_at_least_counts_partially_free_users(self):
+        users = b''.join(slots.to_bytes(42) for slots in [0b0111, 0b0101, 0b1000])
+        events = (0b0111).to_bytes(42)
+
+        self.assertEqual([2], list(schedules.native.at_least(users, events, 0.5)))
+        self.assertEqual([1], list(schedules.native.at_least(users, events, 1)))
+
+    def test_native_at_least_counts_exact_ratios(self):
+        # 0.28 * 25 is slightly above 7 in binary floating point.
+        users = ((1 << 7) - 1).to_bytes(42)
+        events = ((1 << 25) - 1).to_bytes(42)
+
+        self.assertEqual([1], list(schedules.native.at_least(users, events, 0.28)))